@@ -1,23 +1,118 @@
-﻿#include <iostream>
+﻿#include <algorithm>
+#include <iostream>
 #include <iterator>
+#include <limits>
 #include <string>
 #include <filesystem>
 #include <fstream>
 #include <regex>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#ifdef _WIN32
+#define NOMINMAX
 #include <windows.h> 
+#else
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace fs = std::filesystem;
 
+// Цвета текста консоли, общие для Windows и Linux
+enum class ConsoleColor
+{
+    Default,
+    Green,
+    Yellow,
+    Red,
+    LightRed,
+    White
+};
+
+// Установка цвета текста консоли
+void setConsoleColor(ConsoleColor color)
+{
+#ifdef _WIN32
+    WORD attribute = FOREGROUND_RED | FOREGROUND_BLUE | FOREGROUND_GREEN;
+    switch (color)
+    {
+    case ConsoleColor::Green: attribute = FOREGROUND_GREEN; break;
+    case ConsoleColor::Yellow: attribute = FOREGROUND_GREEN | FOREGROUND_RED; break;
+    case ConsoleColor::Red: attribute = FOREGROUND_RED; break;
+    case ConsoleColor::LightRed: attribute = 12; break;
+    case ConsoleColor::White: attribute = 15; break;
+    default: break;
+    }
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), attribute);
+#else
+    // ANSI escape-последовательности для терминалов Linux
+    const char* code = "\033[0m";
+    switch (color)
+    {
+    case ConsoleColor::Green: code = "\033[32m"; break;
+    case ConsoleColor::Yellow: code = "\033[33m"; break;
+    case ConsoleColor::Red: code = "\033[31m"; break;
+    case ConsoleColor::LightRed: code = "\033[91m"; break;
+    case ConsoleColor::White: code = "\033[97m"; break;
+    default: break;
+    }
+    std::cout << code;
+#endif
+}
+
 class Path
 {
 protected:
     fs::path currentPath;
 
+#ifndef _WIN32
+    // Дескриптор текущей директории, относительно которого выполняются операции (openat, renameat2, unlinkat)
+    int currentDirFd = -1;
+
+    // Замена дескриптора текущей директории с закрытием предыдущего
+    void replaceCurrentDirFd(int fd)
+    {
+        if (currentDirFd >= 0)
+            close(currentDirFd);
+        currentDirFd = fd;
+    }
+#endif
+
 public:
-    // Метод для установки текущего пути
-    void setCurrentPath(const std::string& path)
+    Path() = default;
+    Path(const Path&) = delete;
+    Path& operator=(const Path&) = delete;
+
+#ifndef _WIN32
+    ~Path()
     {
+        replaceCurrentDirFd(-1);
+    }
+#endif
+
+    // Метод для установки текущего пути (false - директорию не удалось открыть, текущий путь не изменен)
+    bool setCurrentPath(const std::string& path)
+    {
+#ifndef _WIN32
+        int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            std::cerr << "Не удалось открыть директорию " << path << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        replaceCurrentDirFd(fd);
+#endif
         currentPath = path;
+        return true;
     }
 
 
@@ -30,7 +125,14 @@ public:
     // Метод для создания папки
     void createFolder(const std::string& name)
     {
+#ifdef _WIN32
         fs::create_directory(currentPath.string() + "/" + name);
+#else
+        if (mkdirat(currentDirFd, name.c_str(), 0777) != 0)
+        {
+            std::cerr << "Не удалось создать папку " << name << ": " << std::strerror(errno) << std::endl;
+        }
+#endif
     }
 };
 
@@ -48,12 +150,34 @@ public:
 
 };
 
+// Объект директории с уже полученными сведениями о типе и размере
+struct DirectoryEntry
+{
+    std::string name;
+    bool isDirectory = false;
+    bool isRegularFile = false;
+    uintmax_t size = 0;
+};
+
+// Шаг массового переименования
+struct RenameStep
+{
+    std::string from;
+    std::string to;
+};
+
+// Журнал массового переименования в текущей директории: пары имен "старое\0новое\0" выполненных шагов
+const std::string renameJournalName = ".fm_rename_journal";
+
 class FileManager : public DiskManager
 {
 public:
     // Метод для отображения содержимого директории
     void showContents(bool showSizes = true, const std::string& mask = "");
 
+    // Вспомогательная функция для чтения списка объектов текущей директории
+    bool listCurrentDirectory(std::vector<DirectoryEntry>& entries);
+
     // Метод для создания файла
     void createFile(const std::string& name);
 
@@ -63,8 +187,11 @@ public:
     // Метод для переименования объекта (файла или папки)
     void rename(const std::string& oldName, const std::string& newName);
 
-    // Метод для чтения текстового файла
-    void readTextFile(const std::string& fileName);
+    // Метод для чтения текстового файла (follow - режим слежения за дописываемым файлом)
+    void readTextFile(const std::string& fileName, bool follow = false, size_t lastLines = 10);
+
+    // Метод для слежения за растущим файлом: последние строки, затем новые записи
+    void followTextFile(const std::string& fileName, size_t lastLines);
 
     // Метод для перехода в директорию
     void navigateToDirectory(const std::string& directoryName);
@@ -84,19 +211,81 @@ public:
     // Вспомогательная функция для проверки соответствия строки маске
     bool matchMask(const std::string& str, const std::string& mask);
 
+    // Метод для массового переименования по маске (например, *.log -> *.log.old или img_*.jpg -> photo_###.jpg)
+    void bulkRename(const std::string& sourceMask, const std::string& targetPattern);
+
+    // Вспомогательная функция для проверки соответствия маске с сохранением фрагментов, совпавших с '*' и '?'
+    bool matchMaskCaptures(const std::string& str, const std::string& mask, std::vector<std::string>* captures);
+
+    // Вспомогательная функция для построения нового имени по шаблону замены
+    std::string applyRenamePattern(const std::string& pattern, const std::vector<std::string>& captures, size_t number);
+
+    // Вспомогательная функция для построения и проверки плана переименования
+    bool buildRenamePlan(const std::vector<std::string>& names, const std::string& sourceMask,
+        const std::string& targetPattern, std::vector<RenameStep>& plan);
+
+    // Вспомогательная функция для переименования без перезаписи существующего объекта
+    bool renameNoReplace(const std::string& from, const std::string& to, std::string& error);
+
+    // Вспомогательная функция для отката шагов журнала в обратном порядке, возвращает шаги, которые не удалось откатить
+    std::vector<RenameStep> rollbackRenames(const std::vector<RenameStep>& journal, bool skipMissing);
+
+    // Вспомогательная функция для отката переименования, прерванного до завершения (по файлу журнала)
+    bool recoverRenameJournal();
+
+    // Вспомогательные функции для файла журнала массового переименования в текущей директории
+    bool openRenameJournal();
+    bool appendRenameJournal(const RenameStep& step);
+    void closeRenameJournal();
+    bool loadRenameJournal(std::vector<RenameStep>& journal);
+    bool saveRenameJournal(const std::vector<RenameStep>& journal);
+    void removeRenameJournal();
+
+    // Вспомогательная функция для проверки существования объекта в текущей директории
+    bool entryExists(const std::string& name);
+
+#ifndef _WIN32
+    // Вспомогательная функция для рекурсивного удаления объекта относительно дескриптора директории
+    bool removeAt(int dirFd, const char* name);
+
+    // Вспомогательная функция для поиска смещения начала последних lineCount строк файла
+    off_t findTailOffset(int fd, off_t size, size_t lineCount);
+
+    // Вспомогательная функция для вычисления размера папки в байтах относительно дескриптора директории
+    uintmax_t folderSizeAt(int dirFd, const char* name);
+
+    // Вспомогательная функция для поиска файлов по маске в подпапках (дескриптор fd закрывается функцией)
+    void searchSubfoldersAt(int fd, const std::string& relativePath, const std::string& mask, int& totalCount, int& errorCount);
+#endif
+
+protected:
+    // Открытый журнал массового переименования
+#ifdef _WIN32
+    std::ofstream renameJournalFile;
+#else
+    int renameJournalFd = -1;
+#endif
+
 };
 
 int main()
 {
+#ifdef _WIN32
     setlocale(LC_ALL, "rus");
     SetConsoleCP(1251);
     SetConsoleOutputCP(1251);
+#else
+    setlocale(LC_ALL, "");
+#endif
 
     FileManager fileManager;
     fileManager.showAllDrives();
     std::string diskPath = fileManager.getValidDiskPath();
 
-    fileManager.setCurrentPath(diskPath);
+    if (!fileManager.setCurrentPath(diskPath))
+    {
+        return 1;
+    }
 
     char choice;
     do
@@ -113,6 +302,8 @@ int main()
             << "9. Вернуться в предыдущую директорию\n"
             << "A. Поиск по маске\n"
             << "B. Поиск по маске во всех подпапках\n"
+            << "F. Следить за текстовым файлом (вывод новых строк)\n"
+            << "R. Массовое переименование по маске\n"
             << "D. Сменить диск\n"
             << "0. Выход\n"
             << "Текущая директория: " << fileManager.getCurrentPath() << std::endl;
@@ -185,6 +376,33 @@ int main()
         case 'B':
             fileManager.searchByMaskInSubfolders();
             break;
+        case 'F':
+        {
+            std::string fileName;
+            size_t lastLines = 10;
+            std::cout << "Введите имя файла для слежения: ";
+            std::cin >> fileName;
+            std::cout << "Сколько последних строк показать: ";
+            if (!(std::cin >> lastLines))
+            {
+                std::cin.clear();
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                std::cout << "Некорректное число строк. Слежение отменено.\n";
+                break;
+            }
+            fileManager.readTextFile(fileName, true, lastLines);
+            break;
+        }
+        case 'R':
+        {
+            std::string sourceMask, targetPattern;
+            std::cout << "Введите маску исходных имен (например, *.log): ";
+            std::cin >> sourceMask;
+            std::cout << "Введите шаблон новых имен (например, *.log.old или photo_###.jpg): ";
+            std::cin >> targetPattern;
+            fileManager.bulkRename(sourceMask, targetPattern);
+            break;
+        }
         case 'D':
             fileManager.showAllDrives();
             fileManager.changeDisk();
@@ -202,6 +420,7 @@ int main()
 }
 
 
+#ifdef _WIN32
 void DiskManager::showAllDrives()
 
 {
@@ -232,6 +451,97 @@ void DiskManager::showAllDrives()
         std::cout << "Диски не найдены.\n";
     }
 }
+#else
+// Раскодирование пробелов и спецсимволов (\040, \011, \012, \134) в путях из mountinfo
+static std::string unescapeMountPath(const std::string& path)
+{
+    std::string result;
+    for (size_t i = 0; i < path.size(); ++i)
+    {
+        if (path[i] == '\\' && i + 3 < path.size())
+        {
+            result += static_cast<char>(std::stoi(path.substr(i + 1, 3), nullptr, 8));
+            i += 3;
+        }
+        else
+        {
+            result += path[i];
+        }
+    }
+    return result;
+}
+
+void DiskManager::showAllDrives()
+
+{
+    // Служебные файловые системы ядра, которые не являются дисками
+    static const std::vector<std::string> pseudoFileSystems = {
+        "proc", "sysfs", "cgroup", "cgroup2", "devpts", "mqueue", "securityfs", "debugfs", "tracefs",
+        "pstore", "bpf", "configfs", "fusectl", "hugetlbfs", "binfmt_misc", "autofs", "efivarfs", "selinuxfs",
+        "devtmpfs", "nsfs", "ramfs", "rpc_pipefs", "nfsd"
+    };
+    // Каталоги, в которых tmpfs используется системой, а не для хранения пользовательских данных
+    static const std::vector<std::string> systemDirectories = { "/dev", "/sys", "/proc", "/run" };
+
+    std::vector<std::string> drives;
+    // индекс точки монтирования в drives; при повторном монтировании видна последняя запись
+    std::unordered_map<std::string, size_t> driveIndex;
+
+    // каждая строка mountinfo: id parent major:minor root mount_point options [поля...] - fstype source super_options
+    std::ifstream mountInfo("/proc/self/mountinfo");
+    std::string line;
+    while (std::getline(mountInfo, line))
+    {
+        std::istringstream fields(line);
+        std::string mountId, parentId, device, root, mountPoint;
+        fields >> mountId >> parentId >> device >> root >> mountPoint;
+
+        std::string fsType, source;
+        size_t separator = line.find(" - ");
+        if (separator != std::string::npos)
+        {
+            std::istringstream tail(line.substr(separator + 3));
+            tail >> fsType >> source;
+        }
+
+        if (mountPoint.empty() ||
+            std::find(pseudoFileSystems.begin(), pseudoFileSystems.end(), fsType) != pseudoFileSystems.end())
+        {
+            continue;
+        }
+        mountPoint = unescapeMountPath(mountPoint);
+        if (fsType == "tmpfs" &&
+            std::any_of(systemDirectories.begin(), systemDirectories.end(), [&](const std::string& directory)
+                { return mountPoint == directory || mountPoint.compare(0, directory.size() + 1, directory + "/") == 0; }))
+        {
+            continue;
+        }
+
+        std::string drive = mountPoint + " (" + fsType + ", " + source + ")";
+        auto known = driveIndex.find(mountPoint);
+        if (known != driveIndex.end())
+        {
+            drives[known->second] = drive;
+        }
+        else
+        {
+            driveIndex.emplace(mountPoint, drives.size());
+            drives.push_back(drive);
+        }
+    }
+
+    if (!drives.empty()) {
+        std::cout << "Доступные точки монтирования:\n";
+        for (const auto& drive : drives)
+        {
+            std::cout << drive << std::endl;
+        }
+    }
+    else {
+        std::cout << "Точки монтирования не найдены.\n";
+    }
+}
+#endif
 
 std::string DiskManager::getValidDiskPath()
 {
@@ -251,47 +561,110 @@ std::string DiskManager::getValidDiskPath()
 void DiskManager::changeDisk()
 {
     std::string newDiskPath = getValidDiskPath();
-    setCurrentPath(newDiskPath);
-    std::cout << "Текущий диск изменен на: " << newDiskPath << std::endl;
+    if (setCurrentPath(newDiskPath))
+    {
+        std::cout << "Текущий диск изменен на: " << newDiskPath << std::endl;
+    }
+    else
+    {
+        std::cout << "Диск не изменен. Текущая директория: " << currentPath.string() << std::endl;
+    }
 }
 
+#ifdef _WIN32
+bool FileManager::listCurrentDirectory(std::vector<DirectoryEntry>& entries)
+
+{
+    std::error_code code;
+    if (!fs::is_directory(currentPath, code))
+        return false;
+
+    for (const auto& item : fs::directory_iterator(currentPath))
+    {
+        DirectoryEntry entry;
+        entry.name = item.path().filename().u8string();
+        entry.isDirectory = item.is_directory(code);
+        entry.isRegularFile = item.is_regular_file(code);
+        if (entry.isRegularFile)
+            entry.size = item.file_size(code);
+        entries.push_back(entry);
+    }
+    return true;
+}
+#else
+bool FileManager::listCurrentDirectory(std::vector<DirectoryEntry>& entries)
+
+{
+    // список читается через дескриптор текущей директории, сведения об объектах - через fstatat по имени
+    int fd = openat(currentDirFd, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    DIR* dir = fd >= 0 ? fdopendir(fd) : nullptr;
+    if (dir == nullptr)
+    {
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+
+    while (dirent* item = readdir(dir))
+    {
+        if (std::strcmp(item->d_name, ".") == 0 || std::strcmp(item->d_name, "..") == 0)
+            continue;
+
+        DirectoryEntry entry;
+        entry.name = item->d_name;
+        // символическая ссылка описывается объектом, на который указывает; битая ссылка - самой ссылкой
+        struct stat entryStat;
+        if (fstatat(dirfd(dir), item->d_name, &entryStat, 0) == 0 ||
+            fstatat(dirfd(dir), item->d_name, &entryStat, AT_SYMLINK_NOFOLLOW) == 0)
+        {
+            entry.isDirectory = S_ISDIR(entryStat.st_mode);
+            entry.isRegularFile = S_ISREG(entryStat.st_mode);
+            if (entry.isRegularFile)
+                entry.size = static_cast<uintmax_t>(entryStat.st_size);
+        }
+        entries.push_back(entry);
+    }
+    closedir(dir);
+    return true;
+}
+#endif
+
 void FileManager::showContents(bool showSizes, const std::string& mask)
 
 {
     try
     {
-        if (!fs::is_empty(currentPath)) // Если папка не пуста
+        std::vector<DirectoryEntry> entries;
+        if (listCurrentDirectory(entries))
         {
-            if (fs::exists(currentPath) && fs::is_directory(currentPath))
+            if (!entries.empty()) // Если папка не пуста
             {
                 std::cout << "Содержимое " << currentPath << ":\n";
 
-                for (const auto& entry : fs::directory_iterator(currentPath))
+                for (const auto& entry : entries)
                 {
-                    auto entryPath = entry.path();
-
                     // Добавлен фильтр по маске
-                    if (mask.empty() || std::regex_match(entryPath.filename().u8string(), std::regex(mask)))
+                    if (mask.empty() || std::regex_match(entry.name, std::regex(mask)))
                     {
                         try
                         {
-                            if (fs::is_directory(entryPath))
+                            if (entry.isDirectory)
                             {
-                                SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), FOREGROUND_GREEN);
-                                std::cout << "Папка: " << entryPath.filename().u8string();
+                                setConsoleColor(ConsoleColor::Green);
+                                std::cout << "Папка: " << entry.name;
                             }
                             else
                             {
-                                SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), FOREGROUND_GREEN | FOREGROUND_RED);
-                                std::cout << "Файл: " << entryPath.filename().u8string();
+                                setConsoleColor(ConsoleColor::Yellow);
+                                std::cout << "Файл: " << entry.name;
                             }
                             // Отображение размера, если флаг showSizes установлен
                             if (showSizes)
                             {
-                                if (fs::is_regular_file(entryPath))
+                                if (entry.isRegularFile)
                                 {
                                     // Определение размер файла в байтах и конвертируем в GB, MB, KB или байты в зависимости от размера
-                                    int fileSizeB = fs::file_size(entryPath);
+                                    uintmax_t fileSizeB = entry.size;
                                     if (fileSizeB >= 1024 * 1024 * 1024)
                                     {
                                         double fileSizeGB = static_cast<double>(fileSizeB) / (1024 * 1024 * 1024);
@@ -312,10 +685,14 @@ void FileManager::showContents(bool showSizes, const std::string& mask)
                                         std::cout << " (Размер: " << fileSizeB << " байт)";
                                     }
                                 }
-                                else if (fs::is_directory(entryPath))
+                                else if (entry.isDirectory)
                                 {
                                     // Определение размера папки в байтах и конвертируем в GB, MB, KB или байты в зависимости от размера
-                                    double folderSizeGB = calculateFolderSizeGB(entryPath);
+#ifdef _WIN32
+                                    double folderSizeGB = calculateFolderSizeGB(currentPath / fs::u8path(entry.name));
+#else
+                                    double folderSizeGB = static_cast<double>(folderSizeAt(currentDirFd, entry.name.c_str())) / (1024 * 1024 * 1024);
+#endif
                                     if (folderSizeGB >= 1.0)
                                     {
                                         std::cout << " (Размер: " << folderSizeGB << " GB)";
@@ -339,25 +716,25 @@ void FileManager::showContents(bool showSizes, const std::string& mask)
 
 
                             std::cout << std::endl;
-                            SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), FOREGROUND_RED | FOREGROUND_BLUE | FOREGROUND_GREEN);
+                            setConsoleColor(ConsoleColor::Default);
                         }
                         catch (const std::exception& e)
                         {
-                            SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), FOREGROUND_RED);
+                            setConsoleColor(ConsoleColor::Red);
                             std::cerr << "\tОшибка при обработке файла/папки: " << e.what() << std::endl;
-                            SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), FOREGROUND_RED | FOREGROUND_BLUE | FOREGROUND_GREEN);
+                            setConsoleColor(ConsoleColor::Default);
                         }
                     }
                 }
             }
             else
             {
-                std::cout << "\tДиректория " << currentPath << " не существует или не является директорией.\n";
+                std::cerr << "Папка пустая." << std::endl;
             }
         }
         else
         {
-            std::cerr << "Папка пустая." << std::endl;
+            std::cout << "\tДиректория " << currentPath << " не существует или не является директорией.\n";
         }
     }
     catch (const std::filesystem::filesystem_error& e)
@@ -377,6 +754,7 @@ void FileManager::showContents(bool showSizes, const std::string& mask)
 void FileManager::createFile(const std::string& name)
 
 {
+#ifdef _WIN32
     fs::path filePath = currentPath / name; // проверка на занятость имени файла
 
     if (!fs::exists(filePath))
@@ -389,6 +767,23 @@ void FileManager::createFile(const std::string& name)
     {
         std::cout << "Файл с именем " << name << " уже существует. Выберите другое имя.\n";
     }
+#else
+    // O_EXCL совмещает проверку на занятость имени и создание файла в одном вызове
+    int fd = openat(currentDirFd, name.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+    if (fd >= 0)
+    {
+        close(fd);
+        std::cout << "Файл успешно создан.\n";
+    }
+    else if (errno == EEXIST)
+    {
+        std::cout << "Файл с именем " << name << " уже существует. Выберите другое имя.\n";
+    }
+    else
+    {
+        std::cerr << "Не удалось создать файл " << name << ": " << std::strerror(errno) << std::endl;
+    }
+#endif
 }
 
 void FileManager::deleteObject(const std::string& name)
@@ -400,7 +795,12 @@ void FileManager::deleteObject(const std::string& name)
         std::string objectPath = (currentPath / name).string();
 
         // проверка, существует ли объект по указанному пути
+#ifdef _WIN32
         if (fs::exists(objectPath))
+#else
+        struct stat objectStat;
+        if (fstatat(currentDirFd, name.c_str(), &objectStat, AT_SYMLINK_NOFOLLOW) == 0)
+#endif
         {
             std::cout << "Вы уверены, что хотите удалить объект " << objectPath << "? (y/n): ";
             char confirmation;
@@ -408,8 +808,19 @@ void FileManager::deleteObject(const std::string& name)
 
             if (confirmation == 'y' || confirmation == 'Y')
             {
+#ifdef _WIN32
                 fs::remove_all(objectPath);
                 std::cout << "Объект успешно удален.\n";
+#else
+                if (removeAt(currentDirFd, name.c_str()))
+                {
+                    std::cout << "Объект успешно удален.\n";
+                }
+                else
+                {
+                    std::cerr << "Ошибка работы с файловой системой: " << std::strerror(errno) << std::endl;
+                }
+#endif
             }
             else
             {
@@ -440,11 +851,20 @@ void FileManager::rename(const std::string& oldName, const std::string& newName)
 {
     try
     {
+#ifdef _WIN32
         std::string oldPath = currentPath.string() + "/" + oldName;
         std::string newPath = currentPath.string() + "/" + newName;
 
         // std::filesystem::rename для переименования файла
         fs::rename(oldPath, newPath);
+#else
+        // renameat2 относительно дескриптора текущей директории, без сборки полных путей
+        if (renameat2(currentDirFd, oldName.c_str(), currentDirFd, newName.c_str(), 0) != 0)
+        {
+            std::cerr << "Ошибка работы с файловой системой: " << std::strerror(errno) << std::endl;
+            return;
+        }
+#endif
         std::cout << "Успешно переименовано, новое имя " << newName << ".";
     }
     catch (const std::filesystem::filesystem_error& e)
@@ -461,7 +881,7 @@ void FileManager::rename(const std::string& oldName, const std::string& newName)
     }
 }
 
-void FileManager::readTextFile(const std::string& fileName)
+void FileManager::readTextFile(const std::string& fileName, bool follow, size_t lastLines)
 
 {
     // поиск последней точки в имени файда
@@ -471,9 +891,15 @@ void FileManager::readTextFile(const std::string& fileName)
     {
         // получение расширение файла, начиная с символа после точки
         std::string extension = fileName.substr(dotPosition + 1);
-        // является ли расширение файла "txt"
-        if (extension == "txt")
+        // является ли расширение файла "txt" или "log"
+        if (extension == "txt" || extension == "log")
         {
+            if (follow)
+            {
+                followTextFile(fileName, lastLines);
+                return;
+            }
+#ifdef _WIN32
             std::ifstream file(currentPath.string() + "/" + fileName);
             if (file.is_open())
             {
@@ -486,6 +912,26 @@ void FileManager::readTextFile(const std::string& fileName)
                 }
                 file.close();
             }
+#else
+            int fd = openat(currentDirFd, fileName.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd >= 0)
+            {
+                // вывод содержимого файла блоками
+                char buffer[64 * 1024];
+                ssize_t bytesRead;
+                char lastChar = '\n';
+                std::cout << "\nСодержимое файла " << fileName << ":\n";
+                while ((bytesRead = read(fd, buffer, sizeof(buffer))) > 0)
+                {
+                    std::cout.write(buffer, bytesRead);
+                    lastChar = buffer[bytesRead - 1];
+                }
+                if (lastChar != '\n')
+                    std::cout << '\n';
+                std::cout.flush();
+                close(fd);
+            }
+#endif
             else
             {
                 std::cout << "Не удалось открыть файл " << fileName << " для чтения.\n";
@@ -493,7 +939,7 @@ void FileManager::readTextFile(const std::string& fileName)
         }
         else
         {
-            std::cout << "Содержимое файла " << fileName << " не .txt. Расширение: " << extension << std::endl;
+            std::cout << "Содержимое файла " << fileName << " не .txt и не .log. Расширение: " << extension << std::endl;
         }
     }
     else
@@ -506,9 +952,18 @@ void FileManager::navigateToDirectory(const std::string& directoryName)
 
 {
     // Формирование нового пути, объединяя текущий путь и имя целевой директории
-    std::string newPath = currentPath.string() + "/" + directoryName;
+    // (абсолютное имя заменяет путь целиком, как и в openat, поэтому путь и дескриптор совпадают)
+    std::string newPath = (currentPath / directoryName).string();
+#ifdef _WIN32
     if (fs::exists(newPath) && fs::is_directory(newPath))
     {
+#else
+    // директория открывается относительно текущей, ядру не нужно заново разбирать весь путь
+    int fd = openat(currentDirFd, directoryName.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        replaceCurrentDirFd(fd);
+#endif
         currentPath = newPath;
         std::cout << "Переход в директорию: " << currentPath << std::endl;
     }
@@ -524,8 +979,18 @@ void FileManager::navigateUp()
     std::string parentPath = fs::path(currentPath).parent_path().u8string();
     if (!parentPath.empty())
     {
+#ifdef _WIN32
         if (fs::exists(parentPath) && fs::is_directory(parentPath))
         {
+#else
+        // Родитель берется лексически из currentPath, а не через openat(currentDirFd, ".."):
+        // после перехода по символической ссылке ".." ведет в другой каталог, и дескриптор
+        // разошелся бы с выводимым путем, по которому работают showContents и поиск.
+        int fd = open(parentPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd >= 0)
+        {
+            replaceCurrentDirFd(fd);
+#endif
             currentPath = parentPath;
             std::cout << "Переход в директорию: " << currentPath << std::endl;
         }
@@ -567,24 +1032,20 @@ void FileManager::searchByMask()
         std::string mask;
         std::cout << "Введите маску файла (например, *.txt): ";
         std::cin >> mask;
-        fs::path currentPathObj(currentPath);
 
-        // lexically_normal() для обработки символов маски
-        fs::path searchPath = currentPathObj.lexically_normal();
+        std::vector<DirectoryEntry> entries;
+        listCurrentDirectory(entries);
 
         bool found = false;
-        for (const auto& entry : fs::directory_iterator(searchPath))
+        for (const auto& entry : entries)
         {
-            // получение имя файла из пути
-            std::string entryName = entry.path().filename().u8string();
-
             // является ли элемент обычным файлом и соответствует ли маске
-            if (fs::is_regular_file(entry) && matchMask(entryName, mask))
+            if (entry.isRegularFile && matchMask(entry.name, mask))
             {
                 found = true;
-                SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 12);
-                std::cout << "Найден файл по маске " << mask << ":\n" << entryName << std::endl;
-                SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 15);
+                setConsoleColor(ConsoleColor::LightRed);
+                std::cout << "Найден файл по маске " << mask << ":\n" << entry.name << std::endl;
+                setConsoleColor(ConsoleColor::White);
             }
         }
 
@@ -619,6 +1080,7 @@ void FileManager::searchByMaskInSubfolders()
         int errorCount = 0;  //  счетчик ошибок
         int totalCount = 0;  //  счетчик всех файлов
 
+#ifdef _WIN32
         for (const auto& entry : fs::recursive_directory_iterator(currentPath, fs::directory_options::skip_permission_denied))
         {
             try
@@ -644,14 +1106,18 @@ void FileManager::searchByMaskInSubfolders()
                 ++errorCount;  // ++ счетчик ошибок
             }
         }
+#else
+        searchSubfoldersAt(openat(currentDirFd, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC), "", mask, totalCount, errorCount);
+        found = totalCount > 0;
+#endif
 
         if (!found)
         {
             std::cout << "Файлы по маске " << mask << " не найдены в подпапках директории " << currentPath << ".\n";
         }
-        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 12);
+        setConsoleColor(ConsoleColor::LightRed);
         std::cout << "Найдено файлов: " << totalCount << std::endl;
-        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 15);
+        setConsoleColor(ConsoleColor::White);
         std::cout << "Не удалось считать из-за ошибок доступа: " << errorCount << std::endl;
     }
     catch (const std::filesystem::filesystem_error& e)
@@ -671,46 +1137,900 @@ void FileManager::searchByMaskInSubfolders()
 bool FileManager::matchMask(const std::string& str, const std::string& mask)
 
 {
-    size_t i = 0, j = 0;
-    while (i < str.size() && j < mask.size())
+    // поиск и массовое переименование отбирают файлы по одним и тем же правилам маски
+    return matchMaskCaptures(str, mask, nullptr);
+}
+
+bool FileManager::matchMaskCaptures(const std::string& str, const std::string& mask, std::vector<std::string>* captures)
+
+{
+    // Границы фрагментов для каждого '*' и '?' маски по порядку; строки собираются только после совпадения.
+    // При несовпадении возврат идет лишь к последней '*', которая захватывает на символ больше: O(n * m).
+    std::vector<size_t> wildcardIndex;
+    std::vector<std::pair<size_t, size_t>> spans;
+    if (captures != nullptr)
     {
-        // Если текущий символ в маске - '*', поиск следующго символа '*'.
-        if (mask[j] == '*')
+        wildcardIndex.resize(mask.size());
+        for (size_t k = 0; k < mask.size(); ++k)
         {
-            size_t k = j + 1;
-            // поиск следующего символа '*' в маске.
-            while (k < mask.size() && mask[k] != '*')
-                ++k;
-
-            // длину подстроки между двумя символами '*'.
-            size_t len = k - j - 1;
-            if (len == 0) // Если длина равна 0, '*' в маске означает любой символ.
+            if (mask[k] == '*' || mask[k] == '?')
             {
-                ++j; // переход к следующему символу в маске.
-                continue;
+                wildcardIndex[k] = spans.size();
+                spans.emplace_back(0, 0);
             }
-            // поиск подстроки в строке, соответствующую выделенной подстроке в маске.
-            size_t pos = str.find(mask.substr(j + 1, len), i);
-            if (pos == std::string::npos)
-                return false;
-
-            // обновление индексов для продолжения сравнения.
-            i = pos + len;
-            j = k;
         }
+    }
 
-        // Если текущий символ в маске совпадает с текущим символом в строке или является '?',
-        // далее к следующему символу в строке и маске.
-        else if (mask[j] == str[i] || mask[j] == '?')
+    size_t i = 0, j = 0;
+    size_t starPosition = std::string::npos; // позиция последней '*' в маске
+    size_t starEnd = 0;                      // конец фрагмента, захваченного этой '*'
+    while (i < str.size())
+    {
+        if (j < mask.size() && mask[j] == '*')
+        {
+            starPosition = j;
+            starEnd = i;
+            if (captures != nullptr)
+                spans[wildcardIndex[j]] = { i, i };
+            ++j;
+        }
+        else if (j < mask.size() && (mask[j] == '?' || mask[j] == str[i]))
         {
+            if (captures != nullptr && mask[j] == '?')
+                spans[wildcardIndex[j]] = { i, i + 1 };
             ++i;
             ++j;
         }
+        else if (starPosition != std::string::npos)
+        {
+            ++starEnd;
+            if (captures != nullptr)
+                spans[wildcardIndex[starPosition]].second = starEnd;
+            i = starEnd;
+            j = starPosition + 1;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    // оставшиеся '*' маски совпадают с пустым фрагментом в конце строки
+    while (j < mask.size() && mask[j] == '*')
+    {
+        if (captures != nullptr)
+            spans[wildcardIndex[j]] = { i, i };
+        ++j;
+    }
+    if (j != mask.size())
+        return false;
+
+    if (captures != nullptr)
+    {
+        captures->clear();
+        for (const auto& span : spans)
+        {
+            captures->push_back(str.substr(span.first, span.second - span.first));
+        }
+    }
+    return true;
+}
+
+std::string FileManager::applyRenamePattern(const std::string& pattern, const std::vector<std::string>& captures, size_t number)
+
+{
+    std::string result;
+    size_t captureIndex = 0;
+    for (size_t k = 0; k < pattern.size(); ++k)
+    {
+        if (pattern[k] == '*' || pattern[k] == '?')
+        {
+            // очередной '*' или '?' шаблона подставляет очередной захваченный фрагмент
+            if (captureIndex < captures.size())
+                result += captures[captureIndex];
+            ++captureIndex;
+        }
+        else if (pattern[k] == '#')
+        {
+            // группа '#' - порядковый номер, дополненный нулями до длины группы
+            size_t width = 0;
+            while (k + width < pattern.size() && pattern[k + width] == '#')
+                ++width;
+            std::string digits = std::to_string(number);
+            if (digits.size() < width)
+                result += std::string(width - digits.size(), '0');
+            result += digits;
+            k += width - 1;
+        }
         else
         {
+            result += pattern[k];
+        }
+    }
+    return result;
+}
+
+bool FileManager::buildRenamePlan(const std::vector<std::string>& names, const std::string& sourceMask,
+    const std::string& targetPattern, std::vector<RenameStep>& plan)
+
+{
+    // каждый '*' и '?' шаблона должен получить фрагмент, захваченный маской
+    size_t maskWildcards = std::count_if(sourceMask.begin(), sourceMask.end(), [](char c) { return c == '*' || c == '?'; });
+    size_t patternWildcards = std::count_if(targetPattern.begin(), targetPattern.end(), [](char c) { return c == '*' || c == '?'; });
+    if (patternWildcards > maskWildcards)
+    {
+        std::cout << "В шаблоне " << targetPattern << " символов '*' и '?' (" << patternWildcards
+            << ") больше, чем в маске " << sourceMask << " (" << maskWildcards << ").\n";
+        return false;
+    }
+
+    // подходящие под маску имена в алфавитном порядке (он же порядок нумерации '#')
+    std::vector<std::pair<std::string, std::vector<std::string>>> matched;
+    for (const auto& name : names)
+    {
+        std::vector<std::string> captures;
+        if (matchMaskCaptures(name, sourceMask, &captures))
+            matched.emplace_back(name, std::move(captures));
+    }
+    std::sort(matched.begin(), matched.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    // отображение старое имя -> новое имя; совпадающие имена пропускаются
+    std::unordered_map<std::string, std::string> targetOf;
+    std::unordered_map<std::string, std::string> sourceOf;
+    std::vector<std::string> sources;
+    for (size_t n = 0; n < matched.size(); ++n)
+    {
+        const std::string& from = matched[n].first;
+        std::string to = applyRenamePattern(targetPattern, matched[n].second, n + 1);
+        if (to.empty() || to == "." || to == ".." || to.find_first_of("/\\") != std::string::npos)
+        {
+            std::cout << "Недопустимое новое имя \"" << to << "\" для " << from << ".\n";
             return false;
         }
+        if (to == from)
+            continue;
+        auto inserted = sourceOf.emplace(to, from);
+        if (!inserted.second)
+        {
+            std::cout << "Конфликт: " << inserted.first->second << " и " << from << " получают одно имя " << to << ".\n";
+            return false;
+        }
+        targetOf.emplace(from, to);
+        sources.push_back(from);
+    }
+
+    // новое имя не должно совпадать с объектом, который остается на месте
+    std::unordered_set<std::string> existing(names.begin(), names.end());
+    for (const auto& from : sources)
+    {
+        const std::string& to = targetOf[from];
+        if (existing.count(to) != 0 && targetOf.count(to) == 0)
+        {
+            std::cout << "Конфликт: объект " << to << " уже существует (переименование " << from << ").\n";
+            return false;
+        }
+    }
+
+    // Переименования образуют цепочки и циклы (у каждого имени не более одного входа и выхода).
+    // Цепочка выполняется с конца, чтобы новое имя было уже освобождено; цикл разрывается временным именем.
+    std::unordered_set<std::string> done;
+    auto unwind = [&](std::string current, const std::string& stop)
+    {
+        while (true)
+        {
+            auto predecessor = sourceOf.find(current);
+            if (predecessor == sourceOf.end() || predecessor->second == stop)
+                return;
+            current = predecessor->second;
+            plan.push_back({ current, targetOf[current] });
+            done.insert(current);
+        }
+    };
+
+    for (const auto& from : sources)
+    {
+        // конец цепочки: новое имя не занято другим переименуемым объектом
+        if (targetOf.count(targetOf[from]) == 0)
+        {
+            plan.push_back({ from, targetOf[from] });
+            done.insert(from);
+            unwind(from, "");
+        }
+    }
+
+    size_t temporaryIndex = 0;
+    for (const auto& from : sources)
+    {
+        if (done.count(from) != 0)
+            continue;
+
+        std::string temporary;
+        do
+        {
+            temporary = ".fm_rename_" + std::to_string(temporaryIndex++);
+        } while (existing.count(temporary) != 0);
+
+        plan.push_back({ from, temporary });
+        done.insert(from);
+        unwind(from, from);
+        plan.push_back({ temporary, targetOf[from] });
+    }
+    return true;
+}
+
+#ifdef _WIN32
+bool FileManager::renameNoReplace(const std::string& from, const std::string& to, std::string& error)
+
+{
+    std::error_code code;
+    // имена собраны в UTF-8, поэтому путь строится через u8path, а не из ANSI-строки
+    if (fs::exists(currentPath / fs::u8path(to), code))
+    {
+        error = "объект уже существует";
+        return false;
+    }
+    fs::rename(currentPath / fs::u8path(from), currentPath / fs::u8path(to), code);
+    if (code)
+    {
+        error = code.message();
+        return false;
+    }
+    return true;
+}
+#else
+bool FileManager::renameNoReplace(const std::string& from, const std::string& to, std::string& error)
+
+{
+    if (renameat2(currentDirFd, from.c_str(), currentDirFd, to.c_str(), RENAME_NOREPLACE) == 0)
+        return true;
+
+    // файловые системы без поддержки RENAME_NOREPLACE: проверка и обычное переименование
+    if (errno == EINVAL)
+    {
+        struct stat targetStat;
+        if (fstatat(currentDirFd, to.c_str(), &targetStat, AT_SYMLINK_NOFOLLOW) == 0)
+            errno = EEXIST;
+        else if (renameat(currentDirFd, from.c_str(), currentDirFd, to.c_str()) == 0)
+            return true;
+    }
+    error = std::strerror(errno);
+    return false;
+}
+#endif
+
+std::vector<RenameStep> FileManager::rollbackRenames(const std::vector<RenameStep>& journal, bool skipMissing)
+
+{
+    std::vector<RenameStep> remaining;
+    std::string error;
+    for (auto step = journal.rbegin(); step != journal.rend(); ++step)
+    {
+        // шаг записывается в журнал до переименования; если нового имени нет, шаг не был выполнен
+        if (skipMissing && !entryExists(step->to))
+            continue;
+        if (!renameNoReplace(step->to, step->from, error))
+        {
+            std::cerr << "Не удалось откатить " << step->to << " -> " << step->from << ": " << error << std::endl;
+            remaining.push_back(*step);
+        }
+    }
+    std::reverse(remaining.begin(), remaining.end());
+    return remaining;
+}
+
+bool FileManager::recoverRenameJournal()
+
+{
+    std::vector<RenameStep> journal;
+    if (!loadRenameJournal(journal))
+        return true;
+
+    std::cout << "Найден журнал прерванного переименования (" << journal.size() << " шагов). Откатить? (y/n): ";
+    char confirmation;
+    std::cin >> confirmation;
+    if (confirmation != 'y' && confirmation != 'Y')
+    {
+        std::cout << "Журнал " << renameJournalName << " сохранен, новое переименование невозможно до его отката или удаления.\n";
+        return false;
+    }
+
+    std::vector<RenameStep> remaining = rollbackRenames(journal, true);
+    if (!remaining.empty())
+    {
+        // в журнале остаются только шаги, которые еще не откачены
+        saveRenameJournal(remaining);
+        std::cout << "Откат выполнен частично, не удалось вернуть объектов: " << remaining.size() << ".\n";
+        return false;
     }
-    // Если достигнут конец и строки, и маски, то  true.
-    return (i == str.size() && j == mask.size());
-}
\ No newline at end of file
+    removeRenameJournal();
+    std::cout << "Прерванное переименование (" << journal.size() << " шагов) отменено.\n";
+    return true;
+}
+
+bool FileManager::saveRenameJournal(const std::vector<RenameStep>& journal)
+
+{
+    if (!openRenameJournal())
+        return false;
+    bool saved = true;
+    for (const auto& step : journal)
+    {
+        saved = saved && appendRenameJournal(step);
+    }
+    closeRenameJournal();
+    return saved;
+}
+
+#ifdef _WIN32
+bool FileManager::openRenameJournal()
+
+{
+    renameJournalFile.open(currentPath / fs::u8path(renameJournalName), std::ios::binary | std::ios::trunc);
+    return renameJournalFile.is_open();
+}
+
+bool FileManager::appendRenameJournal(const RenameStep& step)
+
+{
+    renameJournalFile << step.from << '\0' << step.to << '\0' << std::flush;
+    return static_cast<bool>(renameJournalFile);
+}
+
+void FileManager::closeRenameJournal()
+
+{
+    renameJournalFile.close();
+}
+
+bool FileManager::loadRenameJournal(std::vector<RenameStep>& journal)
+
+{
+    std::ifstream journalFile(currentPath / fs::u8path(renameJournalName), std::ios::binary);
+    if (!journalFile.is_open())
+        return false;
+
+    RenameStep step;
+    while (std::getline(journalFile, step.from, '\0') && std::getline(journalFile, step.to, '\0'))
+    {
+        journal.push_back(step);
+    }
+    return true;
+}
+
+void FileManager::removeRenameJournal()
+
+{
+    std::error_code code;
+    fs::remove(currentPath / fs::u8path(renameJournalName), code);
+}
+
+bool FileManager::entryExists(const std::string& name)
+
+{
+    std::error_code code;
+    return fs::exists(fs::symlink_status(currentPath / fs::u8path(name), code));
+}
+#else
+bool FileManager::openRenameJournal()
+
+{
+    renameJournalFd = openat(currentDirFd, renameJournalName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    return renameJournalFd >= 0;
+}
+
+bool FileManager::appendRenameJournal(const RenameStep& step)
+
+{
+    // запись шага одним вызовом write, без буферизации в процессе
+    std::string record = step.from + '\0' + step.to + '\0';
+    return write(renameJournalFd, record.data(), record.size()) == static_cast<ssize_t>(record.size());
+}
+
+void FileManager::closeRenameJournal()
+
+{
+    if (renameJournalFd >= 0)
+        close(renameJournalFd);
+    renameJournalFd = -1;
+}
+
+bool FileManager::loadRenameJournal(std::vector<RenameStep>& journal)
+
+{
+    int fd = openat(currentDirFd, renameJournalName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    std::string content;
+    char buffer[64 * 1024];
+    ssize_t bytesRead;
+    while ((bytesRead = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        content.append(buffer, bytesRead);
+    }
+    close(fd);
+
+    // записи "старое\0новое\0"; неполная последняя запись отбрасывается
+    size_t position = 0;
+    while (true)
+    {
+        size_t fromEnd = content.find('\0', position);
+        size_t toEnd = fromEnd == std::string::npos ? std::string::npos : content.find('\0', fromEnd + 1);
+        if (toEnd == std::string::npos)
+            break;
+        journal.push_back({ content.substr(position, fromEnd - position), content.substr(fromEnd + 1, toEnd - fromEnd - 1) });
+        position = toEnd + 1;
+    }
+    return true;
+}
+
+void FileManager::removeRenameJournal()
+
+{
+    unlinkat(currentDirFd, renameJournalName.c_str(), 0);
+}
+
+bool FileManager::entryExists(const std::string& name)
+
+{
+    struct stat entryStat;
+    return fstatat(currentDirFd, name.c_str(), &entryStat, AT_SYMLINK_NOFOLLOW) == 0;
+}
+#endif
+
+void FileManager::bulkRename(const std::string& sourceMask, const std::string& targetPattern)
+
+{
+    try
+    {
+        // незавершенный журнал предыдущего запуска откатывается до нового переименования
+        if (!recoverRenameJournal())
+            return;
+
+        // имена объектов текущей директории
+        std::vector<std::string> names;
+#ifdef _WIN32
+        for (const auto& entry : fs::directory_iterator(currentPath))
+        {
+            names.push_back(entry.path().filename().u8string());
+        }
+#else
+        int fd = openat(currentDirFd, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        DIR* dir = fd >= 0 ? fdopendir(fd) : nullptr;
+        if (dir == nullptr)
+        {
+            std::cerr << "Ошибка работы с файловой системой: " << std::strerror(errno) << std::endl;
+            if (fd >= 0)
+                close(fd);
+            return;
+        }
+        while (dirent* entry = readdir(dir))
+        {
+            if (std::strcmp(entry->d_name, ".") != 0 && std::strcmp(entry->d_name, "..") != 0)
+                names.emplace_back(entry->d_name);
+        }
+        closedir(dir);
+#endif
+
+        // весь план строится и проверяется в памяти до первого переименования
+        std::vector<RenameStep> plan;
+        if (!buildRenamePlan(names, sourceMask, targetPattern, plan))
+        {
+            std::cout << "Переименование отменено.\n";
+            return;
+        }
+        if (plan.empty())
+        {
+            std::cout << "Нет объектов для переименования по маске " << sourceMask << ".\n";
+            return;
+        }
+
+        const size_t previewSize = 10;
+        for (size_t k = 0; k < plan.size() && k < previewSize; ++k)
+        {
+            std::cout << "  " << plan[k].from << " -> " << plan[k].to << std::endl;
+        }
+        if (plan.size() > previewSize)
+        {
+            std::cout << "  ... и еще " << plan.size() - previewSize << " шагов\n";
+        }
+        std::cout << "Выполнить " << plan.size() << " переименований? (y/n): ";
+        char confirmation;
+        std::cin >> confirmation;
+        if (confirmation != 'y' && confirmation != 'Y')
+        {
+            std::cout << "Переименование отменено.\n";
+            return;
+        }
+
+        // Журнал выполненных шагов для отката при ошибке. Каждый шаг записывается в файл до переименования,
+        // чтобы после аварийного завершения программы можно было откатить все выполненные шаги.
+        if (!openRenameJournal())
+        {
+            std::cerr << "Не удалось создать журнал " << renameJournalName << ". Переименование отменено." << std::endl;
+            return;
+        }
+
+        std::vector<RenameStep> journal;
+        journal.reserve(plan.size());
+        std::string error;
+        for (const auto& step : plan)
+        {
+            if (!appendRenameJournal(step))
+            {
+                std::cerr << "Ошибка записи журнала " << renameJournalName << ". Переименование остановлено." << std::endl;
+                break;
+            }
+            if (!renameNoReplace(step.from, step.to, error))
+            {
+                std::cerr << "Ошибка при переименовании " << step.from << " -> " << step.to << ": " << error << std::endl;
+                break;
+            }
+            journal.push_back(step);
+        }
+        closeRenameJournal();
+
+        if (journal.size() == plan.size())
+        {
+            removeRenameJournal();
+            std::cout << "Успешно переименовано объектов: " << plan.size() << ".\n";
+            return;
+        }
+
+        // откат выполненных шагов в обратном порядке; в журнале остаются только шаги, которые не удалось откатить
+        std::vector<RenameStep> remaining = rollbackRenames(journal, false);
+        if (remaining.empty())
+        {
+            removeRenameJournal();
+            std::cout << "Выполненные переименования (" << journal.size() << ") отменены.\n";
+        }
+        else
+        {
+            saveRenameJournal(remaining);
+            std::cout << "Откат выполнен частично, не удалось вернуть объектов: " << remaining.size()
+                << ". Журнал сохранен в " << renameJournalName << ".\n";
+        }
+    }
+    catch (const std::filesystem::filesystem_error& e)
+    {
+        std::cerr << "Ошибка работы с файловой системой: " << e.what() << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Необработанное исключение: " << e.what() << std::endl;
+    }
+    catch (...)
+    {
+        std::cerr << "Необработанное неизвестное исключение.\n";
+    }
+}
+
+#ifndef _WIN32
+bool FileManager::removeAt(int dirFd, const char* name)
+
+{
+    struct stat objectStat;
+    if (fstatat(dirFd, name, &objectStat, AT_SYMLINK_NOFOLLOW) != 0)
+        return false;
+
+    // обычный файл или символическая ссылка удаляется сразу
+    if (!S_ISDIR(objectStat.st_mode))
+        return unlinkat(dirFd, name, 0) == 0;
+
+    // содержимое папки удаляется относительно её собственного дескриптора
+    int fd = openat(dirFd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    DIR* dir = fdopendir(fd);
+    if (dir == nullptr)
+    {
+        close(fd);
+        return false;
+    }
+
+    bool removed = true;
+    while (dirent* entry = readdir(dir))
+    {
+        if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0)
+            continue;
+        if (!removeAt(fd, entry->d_name))
+        {
+            removed = false;
+            break;
+        }
+    }
+    int savedErrno = errno;
+    closedir(dir);
+    errno = savedErrno;
+
+    return removed && unlinkat(dirFd, name, AT_REMOVEDIR) == 0;
+}
+
+off_t FileManager::findTailOffset(int fd, off_t size, size_t lineCount)
+
+{
+    if (lineCount == 0)
+        return size;
+
+    // файл читается блоками с конца, пока не встретится lineCount переводов строки
+    char buffer[64 * 1024];
+    size_t newlines = 0;
+    off_t position = size;
+    while (position > 0)
+    {
+        size_t chunk = static_cast<size_t>(std::min<off_t>(sizeof(buffer), position));
+        position -= chunk;
+        if (pread(fd, buffer, chunk, position) != static_cast<ssize_t>(chunk))
+            return 0;
+
+        for (size_t i = chunk; i-- > 0;)
+        {
+            // перевод строки в самом конце файла не начинает новую строку
+            if (buffer[i] != '\n' || position + static_cast<off_t>(i) == size - 1)
+                continue;
+            if (++newlines == lineCount)
+                return position + static_cast<off_t>(i) + 1;
+        }
+    }
+    return 0;
+}
+#endif
+
+#ifdef _WIN32
+void FileManager::followTextFile(const std::string& fileName, size_t lastLines)
+
+{
+    std::cout << "Режим слежения за файлом доступен только в Linux-сборке.\n";
+    readTextFile(fileName);
+}
+#else
+void FileManager::followTextFile(const std::string& fileName, size_t lastLines)
+
+{
+    // интервал накопления новых данных и максимальный объём вывода за один интервал
+    const int batchIntervalMs = 100;
+    const int rotationCheckMs = 1000;
+    const off_t maxBatchBytes = 256 * 1024;
+
+    int fd = openat(currentDirFd, fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat fileStat;
+    if (fd < 0 || fstat(fd, &fileStat) != 0)
+    {
+        std::cout << "Не удалось открыть файл " << fileName << " для чтения.\n";
+        if (fd >= 0)
+            close(fd);
+        return;
+    }
+
+    // Дозапись отслеживается наблюдением за самим файлом, ротация - наблюдением за директорией,
+    // из событий которой учитываются только относящиеся к fileName. Пути берутся через /proc/self/fd,
+    // чтобы наблюдать именно открытые объекты.
+    const uint32_t directoryEvents = IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE;
+    int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    int directoryWatch = -1;
+    int fileWatch = -1;
+    if (inotifyFd >= 0)
+    {
+        directoryWatch = inotify_add_watch(inotifyFd, ("/proc/self/fd/" + std::to_string(currentDirFd)).c_str(), directoryEvents);
+        fileWatch = inotify_add_watch(inotifyFd, ("/proc/self/fd/" + std::to_string(fd)).c_str(), IN_MODIFY);
+    }
+    if (inotifyFd < 0 || directoryWatch < 0 || fileWatch < 0)
+    {
+        std::cerr << "Ошибка inotify: " << std::strerror(errno) << std::endl;
+        if (inotifyFd >= 0)
+            close(inotifyFd);
+        close(fd);
+        return;
+    }
+
+    // остаток строки с именем файла не должен считаться нажатием Enter
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    std::cout << "\nСлежение за файлом " << fileName << ". Нажмите Enter для выхода.\n";
+
+    off_t offset = findTailOffset(fd, fileStat.st_size, lastLines);
+    std::string output;
+    // последние прочитанные байты: если они изменились, файл был усечён и уже дописан заново
+    const size_t signatureSize = 64;
+    std::string lastBytes;
+
+    // усечение проверяется сразу после события, пока новые записи не перекрыли прочитанную часть
+    auto checkTruncation = [&]()
+    {
+        if (fstat(fd, &fileStat) != 0)
+            return;
+        bool truncated = fileStat.st_size < offset;
+        if (!truncated && !lastBytes.empty())
+        {
+            char signature[signatureSize];
+            ssize_t signatureRead = pread(fd, signature, lastBytes.size(), offset - static_cast<off_t>(lastBytes.size()));
+            truncated = signatureRead != static_cast<ssize_t>(lastBytes.size()) ||
+                lastBytes.compare(0, lastBytes.size(), signature, lastBytes.size()) != 0;
+        }
+        if (truncated)
+        {
+            output += "\n[Файл усечён, чтение с начала]\n";
+            offset = 0;
+            lastBytes.clear();
+        }
+    };
+
+    char buffer[64 * 1024];
+    bool changed = true;
+    while (true)
+    {
+        if (changed)
+        {
+            // проверка ротации: под тем же именем появился другой файл
+            struct stat nameStat;
+            bool rotated = fstatat(currentDirFd, fileName.c_str(), &nameStat, 0) == 0 &&
+                (nameStat.st_ino != fileStat.st_ino || nameStat.st_dev != fileStat.st_dev);
+
+            checkTruncation();
+
+            // чтение только дописанных байт; при большом потоке выводится лишь хвост интервала
+            off_t pending = fileStat.st_size - offset;
+            if (pending > maxBatchBytes)
+            {
+                off_t skipped = pending - maxBatchBytes;
+                output += "\n[... пропущено " + std::to_string(skipped) + " байт ...]\n";
+                offset += skipped;
+            }
+            ssize_t bytesRead;
+            while (offset < fileStat.st_size &&
+                (bytesRead = pread(fd, buffer, static_cast<size_t>(std::min<off_t>(sizeof(buffer), fileStat.st_size - offset)), offset)) > 0)
+            {
+                output.append(buffer, bytesRead);
+                offset += bytesRead;
+                lastBytes.append(buffer, bytesRead);
+                if (lastBytes.size() > signatureSize)
+                    lastBytes.erase(0, lastBytes.size() - signatureSize);
+            }
+
+            if (rotated)
+            {
+                int newFd = openat(currentDirFd, fileName.c_str(), O_RDONLY | O_CLOEXEC);
+                if (newFd >= 0)
+                {
+                    inotify_rm_watch(inotifyFd, fileWatch);
+                    close(fd);
+                    fd = newFd;
+                    fstat(fd, &fileStat);
+                    fileWatch = inotify_add_watch(inotifyFd, ("/proc/self/fd/" + std::to_string(fd)).c_str(), IN_MODIFY);
+                    offset = 0;
+                    lastBytes.clear();
+                    output += "\n[Файл " + fileName + " пересоздан, продолжение с начала]\n";
+                    continue;
+                }
+            }
+
+            if (!output.empty())
+            {
+                std::cout.write(output.data(), output.size());
+                std::cout.flush();
+                output.clear();
+            }
+        }
+
+        // ожидание событий файла или нажатия Enter; по таймауту файл проверяется на случай пропущенной ротации
+        pollfd fds[2] = { { inotifyFd, POLLIN, 0 }, { STDIN_FILENO, POLLIN, 0 } };
+        int ready = poll(fds, 2, rotationCheckMs);
+        if (ready < 0 && errno != EINTR)
+            break;
+        if (fds[1].revents != 0)
+            break;
+        changed = ready == 0;
+
+        // вычитывание очереди событий; события других файлов директории пропускаются
+        alignas(inotify_event) char events[4096];
+        ssize_t length;
+        while ((length = read(inotifyFd, events, sizeof(events))) > 0)
+        {
+            for (ssize_t position = 0; position < length;)
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(events + position);
+                if (event->wd == fileWatch ||
+                    (event->wd == directoryWatch && event->len > 0 && fileName == event->name))
+                {
+                    changed = true;
+                }
+                position += sizeof(inotify_event) + event->len;
+            }
+        }
+
+        if (fds[0].revents != 0 && changed)
+        {
+            checkTruncation();
+
+            // пауза для накопления пачки новых строк, Enter по-прежнему прерывает слежение
+            if (poll(&fds[1], 1, batchIntervalMs) > 0)
+                break;
+        }
+    }
+
+    std::string rest;
+    std::getline(std::cin, rest);
+    std::cout << "\nСлежение за файлом " << fileName << " завершено.\n";
+    close(inotifyFd);
+    close(fd);
+}
+#endif
+
+#ifndef _WIN32
+uintmax_t FileManager::folderSizeAt(int dirFd, const char* name)
+
+{
+    int fd = openat(dirFd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    DIR* dir = fd >= 0 ? fdopendir(fd) : nullptr;
+    if (dir == nullptr)
+    {
+        if (fd >= 0)
+            close(fd);
+        return 0;
+    }
+
+    // вложенные папки обходятся через свои дескрипторы, полный путь не собирается
+    uintmax_t sizeBytes = 0;
+    while (dirent* entry = readdir(dir))
+    {
+        if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0)
+            continue;
+        struct stat entryStat;
+        if (fstatat(fd, entry->d_name, &entryStat, AT_SYMLINK_NOFOLLOW) != 0)
+            continue;
+        if (S_ISREG(entryStat.st_mode))
+            sizeBytes += static_cast<uintmax_t>(entryStat.st_size);
+        else if (S_ISDIR(entryStat.st_mode))
+            sizeBytes += folderSizeAt(fd, entry->d_name);
+    }
+    closedir(dir);
+    return sizeBytes;
+}
+
+void FileManager::searchSubfoldersAt(int fd, const std::string& relativePath, const std::string& mask, int& totalCount, int& errorCount)
+
+{
+    DIR* dir = fd >= 0 ? fdopendir(fd) : nullptr;
+    if (dir == nullptr)
+    {
+        // Обработка ошибок файловой системы (например, "Отказано в доступе")
+        std::cerr << "Ошибка работы с файловой системой: " << (relativePath.empty() ? "." : relativePath)
+            << ": " << std::strerror(errno) << std::endl;
+        ++errorCount;
+        if (fd >= 0)
+            close(fd);
+        return;
+    }
+
+    while (dirent* entry = readdir(dir))
+    {
+        if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0)
+            continue;
+
+        // тип берется из d_type, fstatat нужен только если файловая система его не сообщает
+        unsigned char type = entry->d_type;
+        if (type == DT_UNKNOWN)
+        {
+            struct stat entryStat;
+            if (fstatat(fd, entry->d_name, &entryStat, AT_SYMLINK_NOFOLLOW) != 0)
+                continue;
+            type = S_ISDIR(entryStat.st_mode) ? DT_DIR : S_ISREG(entryStat.st_mode) ? DT_REG : DT_UNKNOWN;
+        }
+
+        std::string entryPath = relativePath.empty() ? entry->d_name : relativePath + "/" + entry->d_name;
+        if (type == DT_DIR)
+        {
+            int childFd = openat(fd, entry->d_name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            searchSubfoldersAt(childFd, entryPath, mask, totalCount, errorCount);
+        }
+        else if (type == DT_REG && matchMask(entry->d_name, mask))
+        {
+            std::cout << "Найден файл " << std::endl;
+            std::cout << "  Имя файла: " << entry->d_name << std::endl;
+            std::cout << "  Путь: " << entryPath << std::endl;
+            ++totalCount;
+        }
+    }
+    closedir(dir);
+}
+#endif